@@ -9,6 +9,11 @@
 #include <concepts>
 #include <stdexcept>
 #include <optional>
+#include <utility>
+#include <typeindex>
+#include <unordered_map>
+#include <charconv>
+#include <cstdint>
 #include <boost/system/system_error.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -16,8 +21,31 @@ namespace bj = boost::json;
 
 namespace jsoncpp {
 
+namespace detail {
+
+// 获取第 I 个字段的 JSON 名称（考虑 __jsoncpp_alias_name 别名）
+template <std::size_t I, typename T> constexpr std::string_view field_name() {
+  std::string_view name = boost::pfr::get_name<I, T>();
+  if constexpr (HasAliasFieldName<T>::value) {
+    name = T::__jsoncpp_alias_name(name);
+  }
+  return name;
+}
+
+// 以编译期常量依次调用 f(integral_constant<size_t, 0..N-1>)
+template <std::size_t N, typename F> constexpr void for_each_index(F &&f) {
+  [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    (f(std::integral_constant<std::size_t, Is>{}), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+} // namespace detail
+
 template <typename T> class transform {
 public:
+  // 标记通过 boost::pfr 反射字段的默认转换器（用户特化不带此标记）
+  static constexpr bool reflected = true;
+
   static void trans(const bj::value &jv, T &t) {
     if (!jv.is_object()) {
       throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Expected JSON object for class type");
@@ -26,10 +54,7 @@ public:
     bj::object const &jo = jv.as_object();
     boost::pfr::for_each_field(t, [&](auto &&field, auto index) {
       using FieldType = std::decay_t<decltype(field)>;
-      std::string_view field_name = boost::pfr::get_name<index, T>();
-      if constexpr (detail::HasAliasFieldName<T>::value) {
-        field_name = T::__jsoncpp_alias_name(field_name);
-      }
+      std::string_view field_name = detail::field_name<index, T>();
 
       if (jo.contains(field_name)) {
         const bj::value &field_jv = jo.at(field_name);
@@ -47,21 +72,37 @@ public:
     bj::object obj;
     boost::pfr::for_each_field(t, [&](auto &&field, auto index) {
       using FieldType = std::decay_t<decltype(field)>;
-      std::string_view field_name = boost::pfr::get_name<index, T>();
-      if constexpr (detail::HasAliasFieldName<T>::value) {
-        field_name = T::__jsoncpp_alias_name(field_name);
-      }
+      std::string_view field_name = detail::field_name<index, T>();
       obj[std::string(field_name)] = transform<FieldType>::to_json(field);
     });
     return obj;
   }
 };
 
+namespace detail {
+
+// 检测 transform<T> 是否为按字段反射的默认实现
+template <typename T, typename = void>
+struct is_reflected : std::false_type {};
+
+template <typename T>
+struct is_reflected<T, std::void_t<decltype(transform<T>::reflected)>> : std::bool_constant<transform<T>::reflected> {};
+
+template <typename T>
+inline constexpr bool is_reflected_v = is_reflected<T>::value;
+
+// 按实际长度取出 JSON 字符串内容，不经过 c_str()，保留内嵌的 NUL 字节
+inline std::string_view as_string_view(const bj::string &js) {
+  return std::string_view(js.data(), js.size());
+}
+
+} // namespace detail
+
 template <> class transform<std::string> {
 public:
   static void trans(const bj::value &jv, std::string &t) {
     if (jv.is_string()) {
-      t = jv.as_string().c_str();
+      t.assign(detail::as_string_view(jv.get_string()));
     } else if (jv.is_int64()) {
       t = std::to_string(jv.as_int64());
     } else if (jv.is_uint64()) {
@@ -104,9 +145,108 @@ public:
   }
 };
 
+namespace detail {
+
+// 引用保留模式下的共享对象表：编码时记录已输出对象的 id，解码时按 id 还原共享关系
+class reference_context {
+public:
+  // 当前线程生效的上下文，为空表示未开启引用保留模式
+  static reference_context *&current() {
+    thread_local reference_context *ctx = nullptr;
+    return ctx;
+  }
+
+  // 返回对象的 id，以及它是否是第一次出现。登记的对象在上下文存续期间保持存活，
+  // 避免其被释放后新对象复用同一地址而被误判为 $ref
+  std::pair<uint64_t, bool> enter(std::shared_ptr<const void> object, std::type_index type) {
+    const void *ptr = object.get();
+    auto [it, inserted] = ids_.try_emplace(key{ptr, type}, id_entry{ids_.size() + 1, std::move(object)});
+    return {it->second.id, inserted};
+  }
+
+  void add(const bj::value &id, std::shared_ptr<void> object, std::type_index type) {
+    if (!objects_.try_emplace(id.to_number<uint64_t>(), std::move(object), type).second) {
+      throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Duplicate $id: " + bj::serialize(id));
+    }
+  }
+
+  template <typename T> std::shared_ptr<T> resolve(const bj::value &id) const {
+    auto it = objects_.find(id.to_number<uint64_t>());
+    if (it == objects_.end()) {
+      throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Unresolved $ref: " + bj::serialize(id));
+    }
+    if (it->second.type != std::type_index(typeid(T))) {
+      throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Type mismatch for $ref: " + bj::serialize(id));
+    }
+    return std::static_pointer_cast<T>(it->second.object);
+  }
+
+private:
+  struct key {
+    const void *ptr;
+    std::type_index type;
+    bool operator==(const key &other) const = default;
+  };
+
+  struct key_hash {
+    std::size_t operator()(const key &k) const noexcept {
+      return std::hash<const void *>{}(k.ptr) ^ (k.type.hash_code() * 31);
+    }
+  };
+
+  struct entry {
+    std::shared_ptr<void> object;
+    std::type_index type;
+  };
+
+  struct id_entry {
+    uint64_t id;
+    std::shared_ptr<const void> object;
+  };
+
+  std::unordered_map<key, id_entry, key_hash> ids_;
+  std::unordered_map<uint64_t, entry> objects_;
+};
+
+// 在作用域内暂停引用保留模式，供必须输出完整值的编码器（如规范哈希）使用
+class suspend_references {
+public:
+  suspend_references() : previous_(reference_context::current()) {
+    reference_context::current() = nullptr;
+  }
+
+  ~suspend_references() {
+    reference_context::current() = previous_;
+  }
+
+  suspend_references(const suspend_references &) = delete;
+  suspend_references &operator=(const suspend_references &) = delete;
+
+private:
+  reference_context *previous_;
+};
+
+} // namespace detail
+
 template <typename T> class transform<std::shared_ptr<T>> {
 public:
   static void trans(const bj::value &jv, std::shared_ptr<T> &t) {
+    detail::reference_context *refs = detail::reference_context::current();
+    if (refs && jv.is_object()) {
+      bj::object const &jo = jv.as_object();
+      if (const bj::value *ref = jo.if_contains("$ref")) {
+        t = refs->resolve<T>(*ref);
+        return;
+      }
+      if (const bj::value *id = jo.if_contains("$id")) {
+        // 先登记再解码，使指向自身的 $ref（环）能够解析到同一对象
+        t = std::make_shared<T>();
+        refs->add(*id, t, typeid(T));
+        const bj::value *value = jo.if_contains("$value");
+        transform<T>::trans(value ? *value : jv, *t);
+        return;
+      }
+    }
     t = std::make_shared<T>();
     transform<T>::trans(jv, *t);
   }
@@ -115,7 +255,28 @@ public:
     if (!t) {
       return bj::value{};
     }
-    return transform<T>::to_json(*t);
+    detail::reference_context *refs = detail::reference_context::current();
+    if (!refs) {
+      return transform<T>::to_json(*t);
+    }
+
+    auto [id, first] = refs->enter(t, typeid(T));
+    bj::object obj;
+    if (!first) {
+      obj["$ref"] = id;
+      return obj;
+    }
+    obj["$id"] = id;
+    bj::value jv = transform<T>::to_json(*t);
+    if (jv.is_object() && detail::is_reflected_v<T>) {
+      // 反射对象直接内嵌 $id，其他值放在 $value 中
+      for (auto &kv : jv.as_object()) {
+        obj[kv.key()] = std::move(kv.value());
+      }
+    } else {
+      obj["$value"] = std::move(jv);
+    }
+    return obj;
   }
 };
 
@@ -150,7 +311,7 @@ public:
     if (jv.is_bool()) {
       t = jv.as_bool();
     } else if (jv.is_string()) {
-      std::string fv = jv.as_string().c_str();
+      std::string fv(detail::as_string_view(jv.get_string()));
       if (fv == "true" || fv == "1") {
         t = true;
       } else if (fv == "false" || fv == "0") {
@@ -175,7 +336,7 @@ public:
     if (jv.is_int64()) {
       t = jv.as_int64();
     } else if (jv.is_string()) {
-      std::string fv = jv.as_string().c_str();
+      std::string fv(detail::as_string_view(jv.get_string()));
       try {
         t = std::stoll(fv);
       } catch (const std::exception&) {
@@ -198,7 +359,7 @@ public:
     if (jv.is_double()) {
       t = jv.as_double();
     } else if (jv.is_string()) {
-      std::string fv = jv.as_string().c_str();
+      std::string fv(detail::as_string_view(jv.get_string()));
       try {
         t = std::stof(fv);
       } catch (const std::exception&) {
@@ -230,6 +391,122 @@ private:
   const std::string value;
 };
 
+namespace detail {
+
+// 用增量序列化器把 JSON 值写入 sink，不生成临时字符串
+template <typename Sink> void write_serialized(Sink &sink, const bj::value &jv) {
+  bj::serializer sr;
+  sr.reset(&jv);
+  char buffer[256];
+  while (!sr.done()) {
+    auto sv = sr.read(buffer, sizeof(buffer));
+    sink.append(sv.data(), sv.size());
+  }
+}
+
+} // namespace detail
+
+// 直接写出器：不构造 boost::json::value 树，按类型直接把 JSON 文本写入 sink，
+// 字符串经 write_escaped_string 转义。输出与 boost::json::serialize(transform<T>::to_json(t)) 逐字节一致；
+// 浮点数及自定义 transform 的类型仍借助 boost::json 序列化以保证格式相同。
+// Sink 需提供 put(char) 与 append(const char*, size_t)
+template <typename T> class direct_encoder {
+public:
+  template <typename Sink> static void write(const T &t, Sink &sink) {
+    if constexpr (detail::is_reflected_v<T>) {
+      bool first = true;
+      sink.put('{');
+      boost::pfr::for_each_field(t, [&](auto &&field, auto index) {
+        using FieldType = std::decay_t<decltype(field)>;
+        if (!first) {
+          sink.put(',');
+        }
+        first = false;
+        detail::write_escaped_string(sink, detail::field_name<index, T>());
+        sink.put(':');
+        direct_encoder<FieldType>::write(field, sink);
+      });
+      sink.put('}');
+    } else {
+      detail::write_serialized(sink, transform<T>::to_json(t));
+    }
+  }
+};
+
+template <> class direct_encoder<std::string> {
+public:
+  template <typename Sink> static void write(const std::string &t, Sink &sink) {
+    detail::write_escaped_string(sink, t);
+  }
+};
+
+template <> class direct_encoder<bool> {
+public:
+  template <typename Sink> static void write(const bool &t, Sink &sink) {
+    if (t) {
+      sink.append("true", 4);
+    } else {
+      sink.append("false", 5);
+    }
+  }
+};
+
+// 与 transform<T>::to_json 相同，先转换为 int64_t
+template <std::integral T> class direct_encoder<T> {
+public:
+  template <typename Sink> static void write(const T &t, Sink &sink) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(t));
+    sink.append(buffer, result.ptr - buffer);
+  }
+};
+
+template <typename T> class direct_encoder<std::shared_ptr<T>> {
+public:
+  template <typename Sink> static void write(const std::shared_ptr<T> &t, Sink &sink) {
+    if (!t) {
+      sink.append("null", 4);
+    } else if (detail::reference_context::current()) {
+      // 引用保留模式下 $id/$ref 的分配由 transform 负责
+      detail::write_serialized(sink, transform<std::shared_ptr<T>>::to_json(t));
+    } else {
+      direct_encoder<T>::write(*t, sink);
+    }
+  }
+};
+
+template <typename AV> class direct_encoder<std::vector<AV>> {
+public:
+  template <typename Sink> static void write(const std::vector<AV> &t, Sink &sink) {
+    sink.put('[');
+    for (std::size_t i = 0; i < t.size(); ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      direct_encoder<AV>::write(t[i], sink);
+    }
+    sink.put(']');
+  }
+};
+
+template <typename MV> class direct_encoder<std::map<std::string, MV>> {
+public:
+  template <typename Sink> static void write(const std::map<std::string, MV> &t, Sink &sink) {
+    bool first = true;
+    sink.put('{');
+    for (const auto &[key, value] : t) {
+      if (!first) {
+        sink.put(',');
+      }
+      first = false;
+      detail::write_escaped_string(sink, key);
+      sink.put(':');
+      direct_encoder<MV>::write(value, sink);
+    }
+    sink.put('}');
+  }
+};
+
 template <typename T> std::shared_ptr<T> from_json(const std::string &json) {
   auto jv = bj::parse(json);
   auto t = std::make_shared<T>();
@@ -239,8 +516,10 @@ template <typename T> std::shared_ptr<T> from_json(const std::string &json) {
 
 template <typename T> std::string to_json(const T &obj) {
   try {
-    bj::value jv = transform<T>::to_json(obj);
-    return bj::serialize(jv);
+    std::string out;
+    detail::string_sink sink(out);
+    direct_encoder<T>::write(obj, sink);
+    return out;
   } catch (const std::exception& e) {
     throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), std::string("Failed to serialize to JSON: ") + e.what());
   }
@@ -253,6 +532,37 @@ template <typename T> std::string to_json(const std::shared_ptr<T> &obj) {
   return to_json(*obj);
 }
 
+// 开启引用保留模式（仅对当前线程生效）：作用域内同一 shared_ptr 对象只输出一次，
+// 之后以 {"$ref": id} 引用；解码时按 id 还原共享关系和环
+class preserve_references {
+public:
+  preserve_references() : previous_(detail::reference_context::current()) {
+    detail::reference_context::current() = &context_;
+  }
+
+  ~preserve_references() {
+    detail::reference_context::current() = previous_;
+  }
+
+  preserve_references(const preserve_references &) = delete;
+  preserve_references &operator=(const preserve_references &) = delete;
+
+private:
+  detail::reference_context context_;
+  detail::reference_context *previous_;
+};
+
+template <typename T> std::string to_json_refs(const T &obj) {
+  preserve_references scope;
+  // 显式指定 T，使顶层 shared_ptr 也经过 transform 登记 id
+  return to_json<T>(obj);
+}
+
+template <typename T> std::shared_ptr<T> from_json_refs(const std::string &json) {
+  preserve_references scope;
+  return from_json<T>(json);
+}
+
 }; // namespace jsoncpp
 
 #endif // __INK19_JSONCPP_HPP__
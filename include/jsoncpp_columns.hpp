@@ -0,0 +1,329 @@
+#ifndef __INK19_JSONCPP_COLUMNS_HPP__
+#define __INK19_JSONCPP_COLUMNS_HPP__
+
+#include "jsoncpp.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace jsoncpp {
+
+namespace detail {
+
+// 列有效性位图：所有值都有效时不分配内存
+class validity_bitmap {
+public:
+  void push_back(bool valid) {
+    if (!valid && bits_.empty()) {
+      bits_.assign((size_ >> 6) + 1, ~uint64_t{0});
+    }
+    if (!bits_.empty()) {
+      if ((size_ >> 6) >= bits_.size()) {
+        bits_.push_back(~uint64_t{0});
+      }
+      if (!valid) {
+        bits_[size_ >> 6] &= ~(uint64_t{1} << (size_ & 63));
+        ++null_count_;
+      }
+    }
+    ++size_;
+  }
+
+  // 撤销最后一次 push_back，被撤销的位恢复为有效
+  void pop_back() {
+    --size_;
+    if (!bits_.empty() && !test(size_)) {
+      bits_[size_ >> 6] |= uint64_t{1} << (size_ & 63);
+      --null_count_;
+    }
+  }
+
+  bool test(std::size_t i) const {
+    return bits_.empty() || ((bits_[i >> 6] >> (i & 63)) & 1) != 0;
+  }
+
+  std::size_t null_count() const { return null_count_; }
+
+  // 为空表示全部有效
+  const std::vector<uint64_t> &words() const { return bits_; }
+
+private:
+  std::vector<uint64_t> bits_;
+  std::size_t size_ = 0;
+  std::size_t null_count_ = 0;
+};
+
+// 支持以 string_view 查找的哈希，避免字典查找时构造临时 std::string
+struct string_view_hash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view sv) const noexcept {
+    return std::hash<std::string_view>{}(sv);
+  }
+};
+
+} // namespace detail
+
+// 单个字段的连续列存储；bool 以 uint8_t（0/1）保存，避免 std::vector<bool> 的位压缩代理，
+// 保证每列都可通过 data() 连续访问
+template <typename V, bool Dictionary = false> class column {
+public:
+  using value_type = V;
+  using storage_type = std::conditional_t<std::is_same_v<V, bool>, uint8_t, V>;
+
+  std::size_t size() const { return values_.size(); }
+  void reserve(std::size_t n) { values_.reserve(n); }
+
+  decltype(auto) operator[](std::size_t i) const {
+    if constexpr (std::is_same_v<V, bool>) {
+      return values_[i] != 0;
+    } else {
+      return values_[i];
+    }
+  }
+  const std::vector<storage_type> &values() const { return values_; }
+  const storage_type *data() const { return values_.data(); }
+
+  bool is_valid(std::size_t i) const { return validity_.test(i); }
+  std::size_t null_count() const { return validity_.null_count(); }
+  const detail::validity_bitmap &validity() const { return validity_; }
+
+  void push_back(const V &v) {
+    values_.push_back(v);
+    validity_.push_back(true);
+  }
+
+  void push_null() {
+    values_.emplace_back();
+    validity_.push_back(false);
+  }
+
+  void pop_back() {
+    values_.pop_back();
+    validity_.pop_back();
+  }
+
+  // 将 JSON 值直接解码到列尾部，null 视为缺失
+  void decode(const bj::value &jv) {
+    if (jv.is_null()) {
+      push_null();
+      return;
+    }
+    V v{};
+    transform<V>::trans(jv, v);
+    values_.push_back(std::move(v));
+    validity_.push_back(true);
+  }
+
+  bj::value encode(std::size_t i) const {
+    return transform<V>::to_json((*this)[i]);
+  }
+
+private:
+  std::vector<storage_type> values_;
+  detail::validity_bitmap validity_;
+};
+
+// 字典编码的字符串列：每行只保存一个 uint32_t 编码，缺失值使用 null_code，不占用字典项
+template <> class column<std::string, true> {
+public:
+  using value_type = std::string;
+
+  static constexpr uint32_t null_code = UINT32_MAX;
+
+  std::size_t size() const { return codes_.size(); }
+  void reserve(std::size_t n) { codes_.reserve(n); }
+
+  // 缺失值返回空字符串
+  const std::string &operator[](std::size_t i) const {
+    static const std::string empty;
+    return is_valid(i) ? dictionary_[codes_[i]] : empty;
+  }
+  const std::vector<uint32_t> &codes() const { return codes_; }
+  const std::vector<std::string> &dictionary() const { return dictionary_; }
+
+  bool is_valid(std::size_t i) const { return validity_.test(i); }
+  std::size_t null_count() const { return validity_.null_count(); }
+  const detail::validity_bitmap &validity() const { return validity_; }
+
+  void push_back(std::string_view v) {
+    codes_.push_back(intern(v));
+    validity_.push_back(true);
+  }
+
+  void push_null() {
+    codes_.push_back(null_code);
+    validity_.push_back(false);
+    last_added_ = false;
+  }
+
+  // 撤销最后一次写入，若该次写入新增了字典项则一并移除
+  void pop_back() {
+    codes_.pop_back();
+    validity_.pop_back();
+    if (last_added_) {
+      index_.erase(dictionary_.back());
+      dictionary_.pop_back();
+      last_added_ = false;
+    }
+  }
+
+  void decode(const bj::value &jv) {
+    if (jv.is_null()) {
+      push_null();
+    } else if (jv.is_string()) {
+      push_back(detail::as_string_view(jv.get_string()));
+    } else {
+      std::string v;
+      transform<std::string>::trans(jv, v);
+      push_back(v);
+    }
+  }
+
+  bj::value encode(std::size_t i) const {
+    return transform<std::string>::to_json((*this)[i]);
+  }
+
+private:
+  uint32_t intern(std::string_view v) {
+    auto it = index_.find(v);
+    if (it != index_.end()) {
+      last_added_ = false;
+      return it->second;
+    }
+    uint32_t code = static_cast<uint32_t>(dictionary_.size());
+    dictionary_.emplace_back(v);
+    index_.emplace(dictionary_.back(), code);
+    last_added_ = true;
+    return code;
+  }
+
+  std::vector<uint32_t> codes_;
+  std::vector<std::string> dictionary_;
+  std::unordered_map<std::string, uint32_t, detail::string_view_hash, std::equal_to<>> index_;
+  detail::validity_bitmap validity_;
+  bool last_added_ = false;
+};
+
+// 结构体数组的列式（struct-of-arrays）存储，每个反射字段对应一列
+template <typename T, bool DictionaryStrings = false> class columns {
+  template <typename Seq> struct storage;
+  template <std::size_t... Is> struct storage<std::index_sequence<Is...>> {
+    using type = std::tuple<jsoncpp::column<boost::pfr::tuple_element_t<Is, T>, DictionaryStrings>...>;
+  };
+
+public:
+  static constexpr std::size_t field_count = boost::pfr::tuple_size_v<T>;
+
+  template <std::size_t I> auto &get() { return std::get<I>(columns_); }
+  template <std::size_t I> const auto &get() const { return std::get<I>(columns_); }
+
+  template <std::size_t I> static constexpr std::string_view name() {
+    return detail::field_name<I, T>();
+  }
+
+  std::size_t size() const { return size_; }
+
+  void reserve(std::size_t n) {
+    detail::for_each_index<field_count>([&](auto index) { get<index>().reserve(n); });
+  }
+
+  void push_back(const T &t) {
+    detail::for_each_index<field_count>([&](auto index) {
+      get<index>().push_back(boost::pfr::get<index>(t));
+    });
+    ++size_;
+  }
+
+  // 重建第 i 行，缺失字段保持默认值
+  T row(std::size_t i) const {
+    T t{};
+    detail::for_each_index<field_count>([&](auto index) {
+      if (get<index>().is_valid(i)) {
+        boost::pfr::get<index>(t) = get<index>()[i];
+      }
+    });
+    return t;
+  }
+
+  // 解码一行；任一字段失败时撤销本行已写入的列，保证各列长度一致
+  void decode_row(const bj::object &jo) {
+    std::size_t decoded = 0;
+    try {
+      detail::for_each_index<field_count>([&](auto index) {
+        std::string_view field_name = name<index>();
+        auto it = jo.find(field_name);
+        if (it == jo.end()) {
+          get<index>().push_null();
+        } else {
+          try {
+            get<index>().decode(it->value());
+          } catch (const std::exception& e) {
+            throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), std::string("Failed to convert field '") +
+                                           std::string(field_name) + "': " + e.what());
+          }
+        }
+        ++decoded;
+      });
+    } catch (...) {
+      detail::for_each_index<field_count>([&](auto index) {
+        if (index < decoded) {
+          get<index>().pop_back();
+        }
+      });
+      throw;
+    }
+    ++size_;
+  }
+
+  bj::object encode_row(std::size_t i) const {
+    bj::object obj;
+    detail::for_each_index<field_count>([&](auto index) {
+      if (get<index>().is_valid(i)) {
+        obj[std::string(name<index>())] = get<index>().encode(i);
+      }
+    });
+    return obj;
+  }
+
+private:
+  typename storage<std::make_index_sequence<field_count>>::type columns_;
+  std::size_t size_ = 0;
+};
+
+// JSON 对象数组 <-> 列式存储
+template <typename T, bool DictionaryStrings> class transform<columns<T, DictionaryStrings>> {
+public:
+  static void trans(const bj::value &jv, columns<T, DictionaryStrings> &t) {
+    if (!jv.is_array()) {
+      throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Expected JSON array for columns");
+    }
+
+    bj::array const &ja = jv.as_array();
+    t.reserve(t.size() + ja.size());
+    for (auto &value : ja) {
+      if (!value.is_object()) {
+        throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Expected JSON object for columns row");
+      }
+      t.decode_row(value.as_object());
+    }
+  }
+
+  static bj::value to_json(const columns<T, DictionaryStrings> &t) {
+    bj::array arr;
+    arr.reserve(t.size());
+    for (std::size_t i = 0; i < t.size(); ++i) {
+      arr.push_back(t.encode_row(i));
+    }
+    return arr;
+  }
+};
+
+}; // namespace jsoncpp
+
+#endif // __INK19_JSONCPP_COLUMNS_HPP__
@@ -0,0 +1,599 @@
+#ifndef __INK19_JSONCPP_COMPRESS_HPP__
+#define __INK19_JSONCPP_COMPRESS_HPP__
+
+#include "jsoncpp.hpp"
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#ifdef JSONCPP_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace jsoncpp {
+
+enum class compression {
+  automatic, // 读取时按文件头魔数判断，写入时按扩展名判断
+  none,
+  gzip,
+  zstd,
+};
+
+struct stream_options {
+  compression method = compression::automatic;
+  std::size_t chunk_size = 1 << 16;
+  bool background = false; // 在第二个线程中解压，与解析重叠进行
+  int level = -1;          // 压缩级别，-1 表示使用默认值
+};
+
+namespace detail {
+
+[[noreturn]] inline void throw_stream_error(const std::string &message) {
+  throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), message);
+}
+
+inline compression compression_from_magic(const char *data, std::size_t size) {
+  const auto *p = reinterpret_cast<const unsigned char *>(data);
+  if (size >= 2 && p[0] == 0x1f && p[1] == 0x8b) {
+    return compression::gzip;
+  }
+  if (size >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd) {
+    return compression::zstd;
+  }
+  return compression::none;
+}
+
+inline compression compression_from_path(std::string_view path) {
+  if (path.ends_with(".gz")) {
+    return compression::gzip;
+  }
+  if (path.ends_with(".zst")) {
+    return compression::zstd;
+  }
+  return compression::none;
+}
+
+inline void check_zstd_available([[maybe_unused]] compression method) {
+#ifndef JSONCPP_HAS_ZSTD
+  if (method == compression::zstd) {
+    throw_stream_error("zstd support is not enabled (JSONCPP_HAS_ZSTD)");
+  }
+#endif
+}
+
+} // namespace detail
+
+// 按块读取并解压文件，支持多个拼接的 gzip 成员 / zstd 帧
+class compressed_source {
+public:
+  explicit compressed_source(const std::string &path, compression method = compression::automatic,
+                             std::size_t buffer_size = 1 << 16)
+      : file_(path, std::ios::binary), in_(std::max<std::size_t>(buffer_size, 16)) {
+    if (!file_) {
+      detail::throw_stream_error("Failed to open file: " + path);
+    }
+    fill();
+    method_ = method == compression::automatic ? detail::compression_from_magic(in_ptr_, in_avail_) : method;
+    detail::check_zstd_available(method_);
+
+    if (method_ == compression::gzip) {
+      // 15 + 32：自动识别 gzip/zlib 头
+      if (inflateInit2(&zs_, 15 + 32) != Z_OK) {
+        detail::throw_stream_error("Failed to initialize zlib inflate");
+      }
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      dctx_ = ZSTD_createDCtx();
+      if (!dctx_) {
+        detail::throw_stream_error("Failed to initialize zstd decompression");
+      }
+    }
+#endif
+  }
+
+  ~compressed_source() {
+    if (method_ == compression::gzip) {
+      inflateEnd(&zs_);
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    ZSTD_freeDCtx(dctx_);
+#endif
+  }
+
+  compressed_source(const compressed_source &) = delete;
+  compressed_source &operator=(const compressed_source &) = delete;
+
+  compression method() const { return method_; }
+
+  // 解压最多 size 字节到 out，返回 0 表示已到结尾
+  std::size_t read(char *out, std::size_t size) {
+    std::size_t produced = 0;
+    while (produced < size && !done_) {
+      if (in_avail_ == 0 && !fill()) {
+        if (method_ != compression::none && !member_end_) {
+          detail::throw_stream_error("Unexpected end of compressed stream");
+        }
+        done_ = true;
+        break;
+      }
+      if (member_end_) {
+        reset_member();
+      }
+      produced += step(out + produced, size - produced);
+    }
+    return produced;
+  }
+
+private:
+  bool fill() {
+    file_.read(in_.data(), static_cast<std::streamsize>(in_.size()));
+    in_ptr_ = in_.data();
+    in_avail_ = static_cast<std::size_t>(file_.gcount());
+    return in_avail_ > 0;
+  }
+
+  void reset_member() {
+    member_end_ = false;
+    if (method_ == compression::gzip) {
+      inflateReset(&zs_);
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only);
+    }
+#endif
+  }
+
+  std::size_t step(char *out, std::size_t size) {
+    if (method_ == compression::gzip) {
+      zs_.next_in = reinterpret_cast<Bytef *>(in_ptr_);
+      zs_.avail_in = static_cast<uInt>(in_avail_);
+      zs_.next_out = reinterpret_cast<Bytef *>(out);
+      zs_.avail_out = static_cast<uInt>(std::min<std::size_t>(size, UINT_MAX));
+      uInt capacity = zs_.avail_out;
+      int rc = inflate(&zs_, Z_NO_FLUSH);
+      if (rc == Z_STREAM_END) {
+        member_end_ = true;
+      } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+        detail::throw_stream_error(std::string("gzip decompression failed: ") + (zs_.msg ? zs_.msg : "unknown error"));
+      }
+      in_ptr_ = reinterpret_cast<char *>(zs_.next_in);
+      in_avail_ = zs_.avail_in;
+      return capacity - zs_.avail_out;
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      ZSTD_inBuffer in{in_ptr_, in_avail_, 0};
+      ZSTD_outBuffer o{out, size, 0};
+      std::size_t rc = ZSTD_decompressStream(dctx_, &o, &in);
+      if (ZSTD_isError(rc)) {
+        detail::throw_stream_error(std::string("zstd decompression failed: ") + ZSTD_getErrorName(rc));
+      }
+      if (rc == 0) {
+        member_end_ = true;
+      }
+      in_ptr_ += in.pos;
+      in_avail_ -= in.pos;
+      return o.pos;
+    }
+#endif
+    std::size_t n = std::min(size, in_avail_);
+    std::memcpy(out, in_ptr_, n);
+    in_ptr_ += n;
+    in_avail_ -= n;
+    return n;
+  }
+
+  std::ifstream file_;
+  std::vector<char> in_;
+  char *in_ptr_ = nullptr;
+  std::size_t in_avail_ = 0;
+  compression method_ = compression::none;
+  bool member_end_ = false;
+  bool done_ = false;
+  z_stream zs_{};
+#ifdef JSONCPP_HAS_ZSTD
+  ZSTD_DCtx *dctx_ = nullptr;
+#endif
+};
+
+// 边写边压缩的文件输出
+class compressed_sink {
+public:
+  explicit compressed_sink(const std::string &path, compression method = compression::automatic,
+                           int level = -1, std::size_t buffer_size = 1 << 16)
+      : file_(path, std::ios::binary | std::ios::trunc), out_(std::max<std::size_t>(buffer_size, 16)) {
+    if (!file_) {
+      detail::throw_stream_error("Failed to open file: " + path);
+    }
+    method_ = method == compression::automatic ? detail::compression_from_path(path) : method;
+    detail::check_zstd_available(method_);
+
+    if (method_ == compression::gzip) {
+      // 15 + 16：写出 gzip 头
+      if (deflateInit2(&zs_, level < 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) != Z_OK) {
+        detail::throw_stream_error("Failed to initialize zlib deflate");
+      }
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      cctx_ = ZSTD_createCCtx();
+      if (!cctx_) {
+        detail::throw_stream_error("Failed to initialize zstd compression");
+      }
+      if (level >= 0) {
+        ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level);
+      }
+    }
+#endif
+  }
+
+  ~compressed_sink() {
+    try {
+      finish();
+    } catch (...) {
+    }
+    if (method_ == compression::gzip) {
+      deflateEnd(&zs_);
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    ZSTD_freeCCtx(cctx_);
+#endif
+  }
+
+  compressed_sink(const compressed_sink &) = delete;
+  compressed_sink &operator=(const compressed_sink &) = delete;
+
+  compression method() const { return method_; }
+
+  void write(std::string_view data) { write(data.data(), data.size()); }
+
+  void write(const char *data, std::size_t size) {
+    if (finished_) {
+      detail::throw_stream_error("Write after finish on compressed sink");
+    }
+    if (method_ == compression::gzip) {
+      while (size > 0) {
+        std::size_t n = std::min<std::size_t>(size, UINT_MAX);
+        zs_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        zs_.avail_in = static_cast<uInt>(n);
+        while (zs_.avail_in > 0) {
+          deflate_step(Z_NO_FLUSH);
+        }
+        data += n;
+        size -= n;
+      }
+      return;
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      ZSTD_inBuffer in{data, size, 0};
+      while (in.pos < in.size) {
+        zstd_step(in, ZSTD_e_continue);
+      }
+      return;
+    }
+#endif
+    put(data, size);
+  }
+
+  // 写出压缩流尾部并刷新文件，可重复调用
+  void finish() {
+    if (finished_) {
+      return;
+    }
+    finished_ = true;
+    if (method_ == compression::gzip) {
+      zs_.next_in = nullptr;
+      zs_.avail_in = 0;
+      while (deflate_step(Z_FINISH) != Z_STREAM_END) {
+      }
+    }
+#ifdef JSONCPP_HAS_ZSTD
+    if (method_ == compression::zstd) {
+      ZSTD_inBuffer in{nullptr, 0, 0};
+      while (zstd_step(in, ZSTD_e_end) != 0) {
+      }
+    }
+#endif
+    file_.flush();
+    if (!file_) {
+      detail::throw_stream_error("Failed to write compressed output");
+    }
+  }
+
+private:
+  void put(const char *data, std::size_t size) {
+    file_.write(data, static_cast<std::streamsize>(size));
+    if (!file_) {
+      detail::throw_stream_error("Failed to write compressed output");
+    }
+  }
+
+  int deflate_step(int flush) {
+    zs_.next_out = reinterpret_cast<Bytef *>(out_.data());
+    zs_.avail_out = static_cast<uInt>(out_.size());
+    int rc = deflate(&zs_, flush);
+    if (rc == Z_STREAM_ERROR) {
+      detail::throw_stream_error("gzip compression failed");
+    }
+    put(out_.data(), out_.size() - zs_.avail_out);
+    return rc;
+  }
+
+#ifdef JSONCPP_HAS_ZSTD
+  std::size_t zstd_step(ZSTD_inBuffer &in, ZSTD_EndDirective directive) {
+    ZSTD_outBuffer o{out_.data(), out_.size(), 0};
+    std::size_t rc = ZSTD_compressStream2(cctx_, &o, &in, directive);
+    if (ZSTD_isError(rc)) {
+      detail::throw_stream_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(rc));
+    }
+    put(out_.data(), o.pos);
+    return rc;
+  }
+#endif
+
+  std::ofstream file_;
+  std::vector<char> out_;
+  compression method_ = compression::none;
+  bool finished_ = false;
+  z_stream zs_{};
+#ifdef JSONCPP_HAS_ZSTD
+  ZSTD_CCtx *cctx_ = nullptr;
+#endif
+};
+
+namespace detail {
+
+// 后台线程预先解压若干块，使解压与解析重叠进行
+class prefetch_reader {
+public:
+  prefetch_reader(compressed_source &source, std::size_t chunk_size, std::size_t depth = 4)
+      : source_(source), chunk_size_(chunk_size), depth_(depth), worker_([this] { run(); }) {}
+
+  ~prefetch_reader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  prefetch_reader(const prefetch_reader &) = delete;
+  prefetch_reader &operator=(const prefetch_reader &) = delete;
+
+  // 取出下一块，返回 false 表示已到结尾
+  bool next(std::string &chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return !queue_.empty() || finished_; });
+    if (!queue_.empty()) {
+      chunk = std::move(queue_.front());
+      queue_.pop_front();
+      cv_.notify_all();
+      return true;
+    }
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    return false;
+  }
+
+private:
+  void run() {
+    try {
+      for (;;) {
+        std::string chunk(chunk_size_, '\0');
+        chunk.resize(source_.read(chunk.data(), chunk.size()));
+        if (chunk.empty()) {
+          break;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return queue_.size() < depth_ || stop_; });
+        if (stop_) {
+          break;
+        }
+        queue_.push_back(std::move(chunk));
+        cv_.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    cv_.notify_all();
+  }
+
+  compressed_source &source_;
+  std::size_t chunk_size_;
+  std::size_t depth_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::string> queue_;
+  std::exception_ptr error_;
+  bool stop_ = false;
+  bool finished_ = false;
+  std::jthread worker_;
+};
+
+// 依次对解压出的每一块调用 f(data, size)
+template <typename F> void for_each_chunk(const std::string &path, const stream_options &opts, F &&f) {
+  compressed_source source(path, opts.method, opts.chunk_size);
+  if (opts.background) {
+    prefetch_reader reader(source, opts.chunk_size);
+    std::string chunk;
+    while (reader.next(chunk)) {
+      f(chunk.data(), chunk.size());
+    }
+  } else {
+    std::vector<char> buffer(opts.chunk_size);
+    while (std::size_t n = source.read(buffer.data(), buffer.size())) {
+      f(buffer.data(), n);
+    }
+  }
+}
+
+// 为 direct_encoder 提供 put/append 接口，攒满 capacity 字节后整块交给压缩器
+class buffered_sink {
+public:
+  buffered_sink(compressed_sink &sink, std::size_t capacity)
+      : sink_(sink), capacity_(std::max<std::size_t>(capacity, 16)) {
+    buffer_.reserve(capacity_);
+  }
+
+  void put(char c) {
+    buffer_.push_back(c);
+    if (buffer_.size() >= capacity_) {
+      flush();
+    }
+  }
+
+  void append(const char *data, std::size_t size) {
+    if (buffer_.size() + size > capacity_) {
+      flush();
+      if (size >= capacity_) {
+        sink_.write(data, size);
+        return;
+      }
+    }
+    buffer_.append(data, size);
+  }
+
+  void flush() {
+    if (!buffer_.empty()) {
+      sink_.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+private:
+  compressed_sink &sink_;
+  std::size_t capacity_;
+  std::string buffer_;
+};
+
+} // namespace detail
+
+// 从（可能被压缩的）文件中流式解析 JSON
+template <typename T> std::shared_ptr<T> from_json_file(const std::string &path, const stream_options &opts = {}) {
+  bj::stream_parser parser;
+  detail::for_each_chunk(path, opts, [&](const char *data, std::size_t size) {
+    parser.write(data, size);
+  });
+  parser.finish();
+  auto t = std::make_shared<T>();
+  transform<T>::trans(parser.release(), *t);
+  return t;
+}
+
+// 序列化并边写边压缩到文件：direct_encoder 直接写出文本，不构造完整的 JSON 值树
+template <typename T> void to_json_file(const T &obj, const std::string &path, const stream_options &opts = {}) {
+  compressed_sink sink(path, opts.method, opts.level, opts.chunk_size);
+  detail::buffered_sink out(sink, opts.chunk_size);
+  direct_encoder<T>::write(obj, out);
+  out.flush();
+  sink.finish();
+}
+
+// 流式读取 NDJSON，每解析出一行记录就调用 on_record(T&&)，空行被忽略
+template <typename T, typename F> void read_ndjson(const std::string &path, F &&on_record, const stream_options &opts = {}) {
+  bj::stream_parser parser;
+  bool pending = false;
+  std::size_t line = 1;
+
+  // 解析错误附带行号；用户回调抛出的异常原样传播
+  auto line_error = [&](const std::exception &e) {
+    return boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Failed to parse NDJSON line " +
+                                       std::to_string(line) + ": " + e.what());
+  };
+
+  auto write_segment = [&](std::string_view segment) {
+    try {
+      parser.write(segment.data(), segment.size());
+    } catch (const std::exception& e) {
+      throw line_error(e);
+    }
+  };
+
+  auto finish_line = [&] {
+    T t{};
+    try {
+      parser.finish();
+      transform<T>::trans(parser.release(), t);
+    } catch (const std::exception& e) {
+      throw line_error(e);
+    }
+    pending = false;
+    on_record(std::move(t));
+  };
+
+  detail::for_each_chunk(path, opts, [&](const char *data, std::size_t size) {
+    std::string_view rest(data, size);
+    while (!rest.empty()) {
+      std::size_t nl = rest.find('\n');
+      std::string_view segment = rest.substr(0, nl);
+      if (!pending && segment.find_first_not_of(" \t\r") != std::string_view::npos) {
+        parser.reset();
+        pending = true;
+      }
+      if (pending) {
+        write_segment(segment);
+      }
+      if (nl == std::string_view::npos) {
+        break;
+      }
+      if (pending) {
+        finish_line();
+      }
+      ++line;
+      rest.remove_prefix(nl + 1);
+    }
+  });
+  if (pending) {
+    finish_line();
+  }
+}
+
+// 逐条写出 NDJSON 记录并边写边压缩
+template <typename T> class ndjson_writer {
+public:
+  explicit ndjson_writer(const std::string &path, const stream_options &opts = {})
+      : sink_(path, opts.method, opts.level, opts.chunk_size), out_(sink_, opts.chunk_size) {}
+
+  // 缓冲区中剩余的数据须在 sink_ 析构（结束压缩流）之前写出
+  ~ndjson_writer() {
+    try {
+      out_.flush();
+    } catch (...) {
+    }
+  }
+
+  void write(const T &record) {
+    direct_encoder<T>::write(record, out_);
+    out_.put('\n');
+  }
+
+  void finish() {
+    out_.flush();
+    sink_.finish();
+  }
+
+private:
+  compressed_sink sink_;
+  detail::buffered_sink out_;
+};
+
+}; // namespace jsoncpp
+
+#endif // __INK19_JSONCPP_COMPRESS_HPP__
@@ -6,6 +6,18 @@
 #include <memory>
 #include <map>
 #include <string_view>
+#include <string>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define JSONCPP_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSONCPP_SIMD_NEON 1
+#endif
 
 namespace jsoncpp::detail {
 
@@ -67,6 +79,102 @@ struct is_integral : std::is_integral<T> {};
 template<typename T>
 inline constexpr bool is_integral_v = is_integral<T>::value;
 
+// 返回第一个需要转义的字节（'"'、'\\' 或小于 0x20 的控制字符）的下标，没有则返回 size。
+// 按编译目标选择 AVX2（32 字节）、SSE2/NEON（16 字节）内核，剩余部分逐字节处理
+inline std::size_t find_escape(const char *data, std::size_t size) {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i quote32 = _mm256_set1_epi8('"');
+  const __m256i backslash32 = _mm256_set1_epi8('\\');
+  const __m256i control32 = _mm256_set1_epi8(0x1f);
+  for (; i + 32 <= size; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    // 无符号比较：min(v, 0x1f) == v 即 v <= 0x1f
+    __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, backslash32)),
+                                  _mm256_cmpeq_epi8(_mm256_min_epu8(v, control32), v));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+#endif
+#if defined(JSONCPP_SIMD_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                               _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+#elif defined(JSONCPP_SIMD_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t control = vdupq_n_u8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+    uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)), vcltq_u8(v, control));
+    if (vmaxvq_u8(hit) != 0) {
+      break;
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c < 0x20 || c == '"' || c == '\\') {
+      return i;
+    }
+  }
+  return size;
+}
+
+// 把 std::string 适配为 put/append 接口的输出端
+class string_sink {
+public:
+  explicit string_sink(std::string &out) : out_(out) {}
+  void put(char c) { out_.push_back(c); }
+  void append(const char *data, std::size_t size) { out_.append(data, size); }
+
+private:
+  std::string &out_;
+};
+
+// 输出带引号的 JSON 字符串：只转义 '"'、'\\' 和控制字符（小写 \u00xx），
+// 与 boost::json::serialize 及 RFC 8785 的输出一致。无需转义的连续片段整段拷贝
+template <typename Sink> void write_escaped_string(Sink &sink, std::string_view s) {
+  static constexpr char hex[] = "0123456789abcdef";
+  sink.put('"');
+  std::size_t start = 0;
+  for (;;) {
+    std::size_t i = start + find_escape(s.data() + start, s.size() - start);
+    sink.append(s.data() + start, i - start);
+    if (i == s.size()) {
+      break;
+    }
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    start = i + 1;
+    sink.put('\\');
+    switch (c) {
+    case '"': sink.put('"'); break;
+    case '\\': sink.put('\\'); break;
+    case '\b': sink.put('b'); break;
+    case '\f': sink.put('f'); break;
+    case '\n': sink.put('n'); break;
+    case '\r': sink.put('r'); break;
+    case '\t': sink.put('t'); break;
+    default: {
+      char esc[5] = {'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+      sink.append(esc, sizeof(esc));
+    }
+    }
+  }
+  sink.put('"');
+}
+
 } // namespace jsoncpp::detail
 
 #endif // JSONCPP_DETAIL_HPP
@@ -0,0 +1,549 @@
+#ifndef __INK19_JSONCPP_HASH_HPP__
+#define __INK19_JSONCPP_HASH_HPP__
+
+#include "jsoncpp.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsoncpp {
+
+namespace detail {
+
+// 流式 XXH64，按 32 字节条带增量处理输入
+class xxh64 {
+public:
+  explicit xxh64(uint64_t seed = 0) : seed_(seed) {
+    v_[0] = seed + P1 + P2;
+    v_[1] = seed + P2;
+    v_[2] = seed;
+    v_[3] = seed - P1;
+  }
+
+  void put(char c) {
+    buf_[len_++] = c;
+    ++total_;
+    if (len_ == sizeof(buf_)) {
+      consume(buf_);
+      len_ = 0;
+    }
+  }
+
+  void append(const char *data, std::size_t size) {
+    total_ += size;
+    if (len_ + size < sizeof(buf_)) {
+      std::memcpy(buf_ + len_, data, size);
+      len_ += size;
+      return;
+    }
+    if (len_ != 0) {
+      std::size_t fill = sizeof(buf_) - len_;
+      std::memcpy(buf_ + len_, data, fill);
+      consume(buf_);
+      data += fill;
+      size -= fill;
+      len_ = 0;
+    }
+    for (; size >= sizeof(buf_); data += sizeof(buf_), size -= sizeof(buf_)) {
+      consume(data);
+    }
+    std::memcpy(buf_, data, size);
+    len_ = size;
+  }
+
+  uint64_t digest() const {
+    uint64_t h;
+    if (total_ >= sizeof(buf_)) {
+      h = rotl(v_[0], 1) + rotl(v_[1], 7) + rotl(v_[2], 12) + rotl(v_[3], 18);
+      for (uint64_t v : v_) {
+        h ^= round(0, v);
+        h = h * P1 + P4;
+      }
+    } else {
+      h = seed_ + P5;
+    }
+    h += total_;
+
+    const char *p = buf_;
+    std::size_t n = len_;
+    for (; n >= 8; p += 8, n -= 8) {
+      h ^= round(0, read64(p));
+      h = rotl(h, 27) * P1 + P4;
+    }
+    if (n >= 4) {
+      h ^= uint64_t{read32(p)} * P1;
+      h = rotl(h, 23) * P2 + P3;
+      p += 4;
+      n -= 4;
+    }
+    for (; n > 0; ++p, --n) {
+      h ^= uint64_t{static_cast<unsigned char>(*p)} * P5;
+      h = rotl(h, 11) * P1;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+  }
+
+private:
+  static constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+  static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+  static constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+  static uint64_t rotl(uint64_t x, int r) { return std::rotl(x, r); }
+
+  static uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * P2;
+    acc = rotl(acc, 31);
+    return acc * P1;
+  }
+
+  static uint64_t read64(const char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+      v = std::byteswap(v);
+    }
+    return v;
+  }
+
+  static uint32_t read32(const char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+      v = std::byteswap(v);
+    }
+    return v;
+  }
+
+  void consume(const char *p) {
+    for (int i = 0; i < 4; ++i) {
+      v_[i] = round(v_[i], read64(p + 8 * i));
+    }
+  }
+
+  uint64_t seed_;
+  uint64_t v_[4];
+  char buf_[32];
+  std::size_t len_ = 0;
+  uint64_t total_ = 0;
+};
+
+// 同时计算两路不同种子的 XXH64，组成 128 位指纹
+class fingerprint_sink {
+public:
+  void put(char c) {
+    low_.put(c);
+    high_.put(c);
+  }
+
+  void append(const char *data, std::size_t size) {
+    low_.append(data, size);
+    high_.append(data, size);
+  }
+
+  uint64_t low() const { return low_.digest(); }
+  uint64_t high() const { return high_.digest(); }
+
+private:
+  xxh64 low_{0};
+  xxh64 high_{0x9E3779B97F4A7C15ULL};
+};
+
+// 逐个产生 UTF-16 码元，用于 RFC 8785 要求的键排序
+class utf16_cursor {
+public:
+  explicit utf16_cursor(std::string_view s) : s_(s) {}
+
+  bool done() const { return pending_ == 0 && pos_ >= s_.size(); }
+
+  uint32_t next() {
+    if (pending_ != 0) {
+      uint32_t unit = pending_;
+      pending_ = 0;
+      return unit;
+    }
+    auto byte = [&](std::size_t i) { return static_cast<unsigned char>(s_[i]); };
+    uint32_t c = byte(pos_);
+    std::size_t len = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+    if (c < 0x80 || c < 0xc0 || pos_ + len > s_.size()) {
+      // ASCII 或非法 UTF-8 按单字节处理
+      ++pos_;
+      return c;
+    }
+    uint32_t cp = c & (0x7f >> len);
+    for (std::size_t i = 1; i < len; ++i) {
+      cp = (cp << 6) | (byte(pos_ + i) & 0x3f);
+    }
+    pos_ += len;
+    if (cp >= 0x10000) {
+      cp -= 0x10000;
+      pending_ = 0xdc00 + (cp & 0x3ff);
+      return 0xd800 + (cp >> 10);
+    }
+    return cp;
+  }
+
+private:
+  std::string_view s_;
+  std::size_t pos_ = 0;
+  uint32_t pending_ = 0;
+};
+
+// 按 UTF-16 码元比较两个 UTF-8 字符串
+inline bool utf16_less(std::string_view a, std::string_view b) {
+  // 只有 U+E000 以上的字符在 UTF-8 字节序与 UTF-16 码元序中不同
+  auto needs_utf16 = [](std::string_view s) {
+    return std::any_of(s.begin(), s.end(), [](char c) { return static_cast<unsigned char>(c) >= 0xee; });
+  };
+  if (!needs_utf16(a) && !needs_utf16(b)) {
+    return a < b;
+  }
+  utf16_cursor ca(a), cb(b);
+  while (!ca.done() && !cb.done()) {
+    uint32_t ua = ca.next(), ub = cb.next();
+    if (ua != ub) {
+      return ua < ub;
+    }
+  }
+  return ca.done() && !cb.done();
+}
+
+// 按 ECMAScript Number.prototype.toString 规则输出数字（RFC 8785 第 3.2.2.3 节）
+template <typename Sink> void write_canonical_number(Sink &sink, double d) {
+  if (!std::isfinite(d)) {
+    throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), "Cannot canonicalize non-finite number");
+  }
+  if (d == 0) {
+    sink.put('0');
+    return;
+  }
+  if (d < 0) {
+    sink.put('-');
+    d = -d;
+  }
+
+  // 最短往返表示，形如 "d.ddde+XX"
+  char sci[32];
+  auto res = std::to_chars(sci, sci + sizeof(sci), d, std::chars_format::scientific);
+  std::string_view repr(sci, res.ptr - sci);
+  std::size_t e = repr.find('e');
+  char digits[24];
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < e; ++i) {
+    if (repr[i] != '.') {
+      digits[k++] = repr[i];
+    }
+  }
+  int exponent = 0;
+  std::from_chars(repr.data() + e + (repr[e + 1] == '+' ? 2 : 1), repr.data() + repr.size(), exponent);
+  int n = exponent + 1;
+
+  if (static_cast<int>(k) <= n && n <= 21) {
+    sink.append(digits, k);
+    for (int i = static_cast<int>(k); i < n; ++i) {
+      sink.put('0');
+    }
+  } else if (0 < n && n <= 21) {
+    sink.append(digits, n);
+    sink.put('.');
+    sink.append(digits + n, k - n);
+  } else if (-6 < n && n <= 0) {
+    sink.append("0.", 2);
+    for (int i = n; i < 0; ++i) {
+      sink.put('0');
+    }
+    sink.append(digits, k);
+  } else {
+    sink.put(digits[0]);
+    if (k > 1) {
+      sink.put('.');
+      sink.append(digits + 1, k - 1);
+    }
+    char exp[8];
+    exp[0] = 'e';
+    exp[1] = n - 1 < 0 ? '-' : '+';
+    auto end = std::to_chars(exp + 2, exp + sizeof(exp), std::abs(n - 1)).ptr;
+    sink.append(exp, end - exp);
+  }
+}
+
+// 规范化输出任意 JSON 值：对象键按 UTF-16 排序，数字统一按 double 处理
+template <typename Sink> void write_canonical_value(Sink &sink, const bj::value &jv) {
+  switch (jv.kind()) {
+  case bj::kind::null:
+    sink.append("null", 4);
+    break;
+  case bj::kind::bool_:
+    jv.get_bool() ? sink.append("true", 4) : sink.append("false", 5);
+    break;
+  case bj::kind::int64:
+    write_canonical_number(sink, static_cast<double>(jv.get_int64()));
+    break;
+  case bj::kind::uint64:
+    write_canonical_number(sink, static_cast<double>(jv.get_uint64()));
+    break;
+  case bj::kind::double_:
+    write_canonical_number(sink, jv.get_double());
+    break;
+  case bj::kind::string:
+    write_escaped_string(sink, as_string_view(jv.get_string()));
+    break;
+  case bj::kind::array: {
+    sink.put('[');
+    bool first = true;
+    for (const auto &item : jv.get_array()) {
+      if (!first) {
+        sink.put(',');
+      }
+      first = false;
+      write_canonical_value(sink, item);
+    }
+    sink.put(']');
+    break;
+  }
+  case bj::kind::object: {
+    std::vector<const bj::key_value_pair *> members;
+    members.reserve(jv.get_object().size());
+    for (const auto &kv : jv.get_object()) {
+      members.push_back(&kv);
+    }
+    std::sort(members.begin(), members.end(), [](auto *a, auto *b) {
+      return utf16_less(std::string_view(a->key().data(), a->key().size()),
+                        std::string_view(b->key().data(), b->key().size()));
+    });
+    sink.put('{');
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      write_escaped_string(sink, std::string_view(members[i]->key().data(), members[i]->key().size()));
+      sink.put(':');
+      write_canonical_value(sink, members[i]->value());
+    }
+    sink.put('}');
+    break;
+  }
+  }
+}
+
+// 反射字段按 JSON 名称的 UTF-16 顺序排列后的下标，每个类型只计算一次
+template <typename T> const auto &sorted_field_order() {
+  static const auto order = [] {
+    constexpr std::size_t count = boost::pfr::tuple_size_v<T>;
+    std::array<std::string_view, count> names{};
+    std::array<std::size_t, count> result{};
+    for_each_index<count>([&](auto index) {
+      names[index] = field_name<index, T>();
+      result[index] = index;
+    });
+    std::stable_sort(result.begin(), result.end(), [&](std::size_t a, std::size_t b) {
+      return utf16_less(names[a], names[b]);
+    });
+    return result;
+  }();
+  return order;
+}
+
+} // namespace detail
+
+// 以 RFC 8785 规范形式逐字节输出到 sink，不生成中间 JSON 文本
+template <typename T> class canonical_encoder {
+public:
+  template <typename Sink> static void write(const T &t, Sink &sink) {
+    if constexpr (detail::is_reflected_v<T>) {
+      constexpr std::size_t count = boost::pfr::tuple_size_v<T>;
+      static constexpr auto writers = []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<void (*)(const T &, Sink &), count>{&write_field<Is, Sink>...};
+      }(std::make_index_sequence<count>{});
+
+      const auto &order = detail::sorted_field_order<T>();
+      sink.put('{');
+      for (std::size_t k = 0; k < count; ++k) {
+        if (k != 0) {
+          sink.put(',');
+        }
+        writers[order[k]](t, sink);
+      }
+      sink.put('}');
+    } else {
+      detail::write_canonical_value(sink, transform<T>::to_json(t));
+    }
+  }
+
+private:
+  template <std::size_t I, typename Sink> static void write_field(const T &t, Sink &sink) {
+    using FieldType = std::remove_cv_t<boost::pfr::tuple_element_t<I, T>>;
+    detail::write_escaped_string(sink, detail::field_name<I, T>());
+    sink.put(':');
+    canonical_encoder<FieldType>::write(boost::pfr::get<I>(t), sink);
+  }
+};
+
+template <> class canonical_encoder<std::string> {
+public:
+  template <typename Sink> static void write(const std::string &t, Sink &sink) {
+    detail::write_escaped_string(sink, t);
+  }
+};
+
+template <> class canonical_encoder<bool> {
+public:
+  template <typename Sink> static void write(const bool &t, Sink &sink) {
+    t ? sink.append("true", 4) : sink.append("false", 5);
+  }
+};
+
+template <std::integral T> class canonical_encoder<T> {
+public:
+  template <typename Sink> static void write(const T &t, Sink &sink) {
+    // 与 transform<T>::to_json 一致，先转换为 int64_t；RFC 8785 再按 double 输出，
+    // 因此绝对值超过 2^53 的整数会丢失精度
+    detail::write_canonical_number(sink, static_cast<double>(static_cast<int64_t>(t)));
+  }
+};
+
+template <std::floating_point T> class canonical_encoder<T> {
+public:
+  template <typename Sink> static void write(const T &t, Sink &sink) {
+    detail::write_canonical_number(sink, static_cast<double>(t));
+  }
+};
+
+template <typename T> class canonical_encoder<std::shared_ptr<T>> {
+public:
+  template <typename Sink> static void write(const std::shared_ptr<T> &t, Sink &sink) {
+    if (!t) {
+      sink.append("null", 4);
+      return;
+    }
+    canonical_encoder<T>::write(*t, sink);
+  }
+};
+
+template <typename AV> class canonical_encoder<std::vector<AV>> {
+public:
+  template <typename Sink> static void write(const std::vector<AV> &t, Sink &sink) {
+    sink.put('[');
+    for (std::size_t i = 0; i < t.size(); ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      canonical_encoder<AV>::write(t[i], sink);
+    }
+    sink.put(']');
+  }
+};
+
+template <typename MV> class canonical_encoder<std::map<std::string, MV>> {
+public:
+  template <typename Sink> static void write(const std::map<std::string, MV> &t, Sink &sink) {
+    // std::map 按字节序排列，只有出现 U+E000 以上字符时才需要重新按 UTF-16 排序
+    bool reorder = std::any_of(t.begin(), t.end(), [](const auto &kv) {
+      return std::any_of(kv.first.begin(), kv.first.end(), [](char c) { return static_cast<unsigned char>(c) >= 0xee; });
+    });
+    if (!reorder) {
+      sink.put('{');
+      bool first = true;
+      for (const auto &[key, value] : t) {
+        if (!first) {
+          sink.put(',');
+        }
+        first = false;
+        write_member(key, value, sink);
+      }
+      sink.put('}');
+      return;
+    }
+
+    std::vector<const typename std::map<std::string, MV>::value_type *> members;
+    members.reserve(t.size());
+    for (const auto &kv : t) {
+      members.push_back(&kv);
+    }
+    std::sort(members.begin(), members.end(), [](auto *a, auto *b) { return detail::utf16_less(a->first, b->first); });
+    sink.put('{');
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      write_member(members[i]->first, members[i]->second, sink);
+    }
+    sink.put('}');
+  }
+
+private:
+  template <typename Sink> static void write_member(const std::string &key, const MV &value, Sink &sink) {
+    detail::write_escaped_string(sink, key);
+    sink.put(':');
+    canonical_encoder<MV>::write(value, sink);
+  }
+};
+
+struct fingerprint {
+  uint64_t high = 0;
+  uint64_t low = 0;
+
+  bool operator==(const fingerprint &other) const = default;
+};
+
+// RFC 8785 规范 JSON 文本，主要用于调试和校验 hash 结果
+template <typename T> std::string to_canonical_json(const T &obj) {
+  detail::suspend_references no_refs;
+  std::string out;
+  detail::string_sink sink(out);
+  canonical_encoder<T>::write(obj, sink);
+  return out;
+}
+
+// 等于 XXH64(to_canonical_json(obj), seed)，但不分配 JSON 文本。
+// 始终对完整值计算，忽略 preserve_references 作用域。
+// 注意：按 RFC 8785，整数字段按 double 规范化——绝对值超过 2^53 的相邻整数会得到相同的哈希，
+// 超过 INT64_MAX 的无符号整数先（与 to_json 一样）回绕为负数。需要按大整数 id 去重时，
+// 请把这类 id 存为字符串字段
+template <typename T> uint64_t hash(const T &obj, uint64_t seed = 0) {
+  detail::suspend_references no_refs;
+  detail::xxh64 sink(seed);
+  canonical_encoder<T>::write(obj, sink);
+  return sink.digest();
+}
+
+// 128 位指纹，规范化规则（包括上面的整数精度限制）与 hash 相同
+template <typename T> fingerprint fingerprint128(const T &obj) {
+  detail::suspend_references no_refs;
+  detail::fingerprint_sink sink;
+  canonical_encoder<T>::write(obj, sink);
+  return {sink.high(), sink.low()};
+}
+
+// 对任意 JSON 文本计算同样的规范哈希，可与 hash<T>(obj) 直接比较
+inline uint64_t hash_json(std::string_view json, uint64_t seed = 0) {
+  bj::value jv = bj::parse(bj::string_view(json.data(), json.size()));
+  detail::xxh64 sink(seed);
+  detail::write_canonical_value(sink, jv);
+  return sink.digest();
+}
+
+inline fingerprint fingerprint128_json(std::string_view json) {
+  bj::value jv = bj::parse(bj::string_view(json.data(), json.size()));
+  detail::fingerprint_sink sink;
+  detail::write_canonical_value(sink, jv);
+  return {sink.high(), sink.low()};
+}
+
+}; // namespace jsoncpp
+
+#endif // __INK19_JSONCPP_HASH_HPP__
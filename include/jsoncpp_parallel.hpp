@@ -0,0 +1,221 @@
+#ifndef __INK19_JSONCPP_PARALLEL_HPP__
+#define __INK19_JSONCPP_PARALLEL_HPP__
+
+#include "jsoncpp.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace jsoncpp {
+
+// 并行序列化选项：元素数量达到 threshold 的 vector/map 会被切分为
+// chunk_size 大小的区间，在 threads 个线程上分别编码后按顺序拼接
+struct parallel_options {
+  std::size_t threshold = 1 << 16;
+  std::size_t chunk_size = 1 << 14;
+  unsigned threads = 0; // 0 表示使用 std::thread::hardware_concurrency()
+};
+
+namespace detail {
+
+// 将 [0, count) 按 chunk_size 切分，在线程池中调用 encode_range(begin, end)，
+// 返回按区间顺序排列的编码结果
+template <typename F>
+std::vector<std::string> encode_chunks(std::size_t count, const parallel_options &opts, F &&encode_range) {
+  std::size_t chunk = std::max<std::size_t>(opts.chunk_size, 1);
+  std::size_t chunk_count = (count + chunk - 1) / chunk;
+  std::vector<std::string> buffers(chunk_count);
+
+  std::size_t thread_count = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, chunk_count);
+
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&] {
+    for (std::size_t c; (c = next.fetch_add(1)) < chunk_count;) {
+      try {
+        buffers[c] = encode_range(c * chunk, std::min(count, (c + 1) * chunk));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = chunk_count;
+        return;
+      }
+    }
+  };
+
+  {
+    std::vector<std::jthread> pool;
+    for (std::size_t i = 1; i < thread_count; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return buffers;
+}
+
+// 每个缓冲区是以逗号分隔的若干元素，加上首尾括号后以逗号拼接，只做一次最终拷贝
+inline void stitch_chunks(std::string &out, char open, const std::vector<std::string> &buffers, char close) {
+  std::size_t total = 2 + buffers.size();
+  for (const auto &buffer : buffers) {
+    total += buffer.size();
+  }
+  out.reserve(out.size() + total);
+  out.push_back(open);
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    if (i != 0) {
+      out.push_back(',');
+    }
+    out += buffers[i];
+  }
+  out.push_back(close);
+}
+
+inline void write_key(std::string &out, std::string_view key) {
+  string_sink sink(out);
+  write_escaped_string(sink, key);
+  out.push_back(':');
+}
+
+} // namespace detail
+
+// 并行编码器，输出与 jsoncpp::to_json 逐字节一致；分块内与叶子值交给 direct_encoder 直接写出
+template <typename T> class parallel_encoder {
+public:
+  static void write(const T &t, std::string &out, const parallel_options &opts) {
+    if constexpr (detail::is_reflected_v<T>) {
+      bool first = true;
+      out.push_back('{');
+      boost::pfr::for_each_field(t, [&](auto &&field, auto index) {
+        using FieldType = std::decay_t<decltype(field)>;
+        if (!first) {
+          out.push_back(',');
+        }
+        first = false;
+        detail::write_key(out, detail::field_name<index, T>());
+        parallel_encoder<FieldType>::write(field, out, opts);
+      });
+      out.push_back('}');
+    } else {
+      detail::string_sink sink(out);
+      direct_encoder<T>::write(t, sink);
+    }
+  }
+};
+
+// 只在未开启引用保留模式时使用（见 to_json_parallel），与 transform<shared_ptr<T>> 输出一致
+template <typename T> class parallel_encoder<std::shared_ptr<T>> {
+public:
+  static void write(const std::shared_ptr<T> &t, std::string &out, const parallel_options &opts) {
+    if (!t) {
+      out += "null";
+      return;
+    }
+    parallel_encoder<T>::write(*t, out, opts);
+  }
+};
+
+template <typename AV> class parallel_encoder<std::vector<AV>> {
+public:
+  static void write(const std::vector<AV> &t, std::string &out, const parallel_options &opts) {
+    if (t.size() >= opts.threshold) {
+      auto buffers = detail::encode_chunks(t.size(), opts, [&](std::size_t begin, std::size_t end) {
+        std::string buffer;
+        detail::string_sink sink(buffer);
+        for (std::size_t i = begin; i < end; ++i) {
+          if (i != begin) {
+            sink.put(',');
+          }
+          direct_encoder<AV>::write(t[i], sink);
+        }
+        return buffer;
+      });
+      detail::stitch_chunks(out, '[', buffers, ']');
+    } else {
+      out.push_back('[');
+      for (std::size_t i = 0; i < t.size(); ++i) {
+        if (i != 0) {
+          out.push_back(',');
+        }
+        parallel_encoder<AV>::write(t[i], out, opts);
+      }
+      out.push_back(']');
+    }
+  }
+};
+
+template <typename MV> class parallel_encoder<std::map<std::string, MV>> {
+public:
+  static void write(const std::map<std::string, MV> &t, std::string &out, const parallel_options &opts) {
+    if (t.size() >= opts.threshold) {
+      // map 不支持随机访问，先记录每个区间的起始迭代器
+      std::size_t chunk = std::max<std::size_t>(opts.chunk_size, 1);
+      std::vector<typename std::map<std::string, MV>::const_iterator> starts;
+      starts.reserve(t.size() / chunk + 1);
+      std::size_t i = 0;
+      for (auto it = t.begin(); it != t.end(); ++it, ++i) {
+        if (i % chunk == 0) {
+          starts.push_back(it);
+        }
+      }
+
+      auto buffers = detail::encode_chunks(t.size(), opts, [&](std::size_t begin, std::size_t end) {
+        std::string buffer;
+        auto it = starts[begin / chunk];
+        for (std::size_t j = begin; j < end; ++j, ++it) {
+          if (j != begin) {
+            buffer.push_back(',');
+          }
+          detail::write_key(buffer, it->first);
+          detail::string_sink sink(buffer);
+          direct_encoder<MV>::write(it->second, sink);
+        }
+        return buffer;
+      });
+      detail::stitch_chunks(out, '{', buffers, '}');
+    } else {
+      bool first = true;
+      out.push_back('{');
+      for (const auto &[key, value] : t) {
+        if (!first) {
+          out.push_back(',');
+        }
+        first = false;
+        detail::write_key(out, key);
+        parallel_encoder<MV>::write(value, out, opts);
+      }
+      out.push_back('}');
+    }
+  }
+};
+
+// 并行序列化：大容器在线程池中分块编码，结果与 to_json 完全一致。
+// 引用保留模式下 id 的分配依赖编码顺序，且上下文是线程局部的，因此回退为串行 to_json
+template <typename T> std::string to_json_parallel(const T &obj, const parallel_options &opts = {}) {
+  if (detail::reference_context::current()) {
+    return to_json(obj);
+  }
+  try {
+    std::string out;
+    parallel_encoder<T>::write(obj, out, opts);
+    return out;
+  } catch (const std::exception& e) {
+    throw boost::system::system_error(boost::system::error_code(-1, boost::system::generic_category()), std::string("Failed to serialize to JSON: ") + e.what());
+  }
+}
+
+}; // namespace jsoncpp
+
+#endif // __INK19_JSONCPP_PARALLEL_HPP__
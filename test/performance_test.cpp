@@ -1,8 +1,20 @@
 #include "jsoncpp.hpp"
+#include "jsoncpp_compress.hpp"
 #include <chrono>
 #include <iostream>
 #include <vector>
 
+#ifndef JSONCPP_TEST_FIXTURE_DIR
+#define JSONCPP_TEST_FIXTURE_DIR "test/fixtures"
+#endif
+
+class event_data {
+public:
+    int id;
+    std::string level;
+    double score;
+};
+
 class performance_data {
 public:
     int id;
@@ -102,7 +114,33 @@ void run_performance_test() {
     }
 }
 
+void run_compressed_throughput_test() {
+    std::cout << "\n=== 压缩流吞吐测试 ===\n";
+
+    const int iterations = 100;
+    for (bool background : {false, true}) {
+        jsoncpp::stream_options opts;
+        opts.background = background;
+
+        std::size_t records = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            jsoncpp::read_ndjson<event_data>(JSONCPP_TEST_FIXTURE_DIR "/events.ndjson.gz", [&](event_data &&) {
+                ++records;
+            }, opts);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+        std::cout << "NDJSON.gz 解码 (" << (background ? "后台解压" : "同线程解压") << ", " << iterations << " 次迭代):\n";
+        std::cout << "  总时间: " << duration.count() << " 微秒\n";
+        std::cout << "  记录数: " << records << "\n";
+        std::cout << "  吞吐: " << (duration.count() ? records * 1000000 / duration.count() : 0) << " 条/秒\n";
+    }
+}
+
 int main() {
     run_performance_test();
+    run_compressed_throughput_test();
     return 0;
 }
@@ -1,6 +1,20 @@
 #include "jsoncpp.hpp"
+#include "jsoncpp_columns.hpp"
+#include "jsoncpp_parallel.hpp"
+#include "jsoncpp_compress.hpp"
+#include "jsoncpp_hash.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
 #include <gtest/gtest.h>
 
+#ifndef JSONCPP_TEST_FIXTURE_DIR
+#define JSONCPP_TEST_FIXTURE_DIR "test/fixtures"
+#endif
+
 class ext_data {
 public:
     int data;
@@ -348,6 +362,525 @@ TEST(JsonCppTest, FloatingPointTest) {
     EXPECT_TRUE(serialized.find("3.14") != std::string::npos);
 }
 
+// 列式解码测试用的记录类型
+class record_data {
+public:
+    int id;
+    std::string level;
+    double score;
+};
+
+TEST(JsonCppTest, ColumnsTest) {
+    // 测试对象数组直接解码为列，缺失字段记录在有效性位图中
+    std::string json_str = "[{\"id\":1, \"level\":\"info\", \"score\":0.5},"
+                           " {\"id\":2, \"level\":\"warn\"},"
+                           " {\"id\":3, \"level\":\"info\", \"score\":1.5},"
+                           " {\"id\":4}]";
+    auto cols = jsoncpp::from_json<jsoncpp::columns<record_data, true>>(json_str);
+
+    EXPECT_EQ(cols->size(), 4);
+    EXPECT_EQ(cols->get<0>().values(), (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(cols->get<1>()[2], "info");
+    EXPECT_EQ(cols->get<2>().null_count(), 2);
+    EXPECT_FALSE(cols->get<2>().is_valid(1));
+    EXPECT_DOUBLE_EQ(cols->get<2>()[2], 1.5);
+
+    // 缺失的字符串不占用字典项
+    EXPECT_EQ(cols->get<1>().dictionary(), (std::vector<std::string>{"info", "warn"}));
+    EXPECT_FALSE(cols->get<1>().is_valid(3));
+    EXPECT_EQ(cols->get<1>().codes()[3], jsoncpp::column<std::string, true>::null_code);
+    EXPECT_EQ(cols->get<1>()[3], "");
+
+    auto row = cols->row(1);
+    EXPECT_EQ(row.id, 2);
+    EXPECT_EQ(row.level, "warn");
+
+    // 缺失字段序列化时省略
+    auto round = jsoncpp::from_json<jsoncpp::columns<record_data>>(jsoncpp::to_json(*cols));
+    EXPECT_EQ(round->size(), 4);
+    EXPECT_EQ(round->get<1>().values(), (std::vector<std::string>{"info", "warn", "info", ""}));
+    EXPECT_EQ(round->get<1>().null_count(), 1);
+    EXPECT_EQ(round->get<2>().null_count(), 2);
+}
+
+TEST(JsonCppTest, ColumnsRollbackTest) {
+    // 测试某行解码失败时已写入的列被撤销，各列长度保持一致
+    auto cols = jsoncpp::from_json<jsoncpp::columns<record_data, true>>("[{\"id\":1, \"level\":\"info\"}]");
+    EXPECT_THROW(jsoncpp::transform<jsoncpp::columns<record_data, true>>::trans(
+                     bj::parse("[{\"id\":2, \"level\":\"new\", \"score\":\"bad\"}]"), *cols),
+                 boost::system::system_error);
+
+    EXPECT_EQ(cols->size(), 1);
+    EXPECT_EQ(cols->get<0>().size(), 1);
+    EXPECT_EQ(cols->get<1>().size(), 1);
+    EXPECT_EQ(cols->get<2>().size(), 1);
+    EXPECT_EQ(cols->get<2>().null_count(), 1);
+    EXPECT_EQ(cols->get<1>().dictionary(), (std::vector<std::string>{"info"}));
+
+    jsoncpp::transform<jsoncpp::columns<record_data, true>>::trans(bj::parse("[{\"id\":3, \"score\":2.5}]"), *cols);
+    EXPECT_EQ(cols->size(), 2);
+    EXPECT_TRUE(cols->get<2>().is_valid(1));
+    EXPECT_EQ(cols->row(1).id, 3);
+}
+
+// 带 bool 字段的列式测试类型
+class flag_data {
+public:
+    int id;
+    bool active;
+};
+
+TEST(JsonCppTest, ColumnsBoolTest) {
+    // 测试 bool 列以 uint8_t 连续存储
+    auto cols = jsoncpp::from_json<jsoncpp::columns<flag_data>>(
+        "[{\"id\":1, \"active\":true}, {\"id\":2, \"active\":false}, {\"id\":3}, {\"id\":4, \"active\":\"true\"}]");
+    const auto &active = cols->get<1>();
+    ASSERT_EQ(active.size(), 4);
+    const uint8_t *data = active.data();
+    EXPECT_EQ(data[0], 1);
+    EXPECT_EQ(data[1], 0);
+    EXPECT_EQ(data[3], 1);
+    EXPECT_FALSE(active.is_valid(2));
+    EXPECT_TRUE(active[0]);
+    EXPECT_FALSE(active[1]);
+    EXPECT_TRUE(cols->row(3).active);
+
+    auto round = jsoncpp::from_json<jsoncpp::columns<flag_data>>(jsoncpp::to_json(*cols));
+    EXPECT_EQ(round->get<1>().values(), active.values());
+    EXPECT_EQ(round->get<1>().null_count(), 1);
+}
+
+// 并行序列化测试用的大容器类型
+class snapshot_data {
+public:
+    std::string name;
+    std::vector<record_data> records;
+    std::map<std::string, int> counters;
+};
+
+TEST(JsonCppTest, ParallelSerializeTest) {
+    // 测试并行序列化结果与串行序列化逐字节一致
+    snapshot_data data;
+    data.name = "snapshot \"1\"";
+    for (int i = 0; i < 5000; ++i) {
+        data.records.push_back({i, i % 3 ? "info" : "warn", i * 0.25});
+        data.counters["key_" + std::to_string(i)] = i;
+    }
+
+    jsoncpp::parallel_options opts;
+    opts.threshold = 100;
+    opts.chunk_size = 64;
+    opts.threads = 4;
+
+    EXPECT_EQ(jsoncpp::to_json_parallel(data, opts), jsoncpp::to_json(data));
+    EXPECT_EQ(jsoncpp::to_json_parallel(data.records, opts), jsoncpp::to_json(data.records));
+    EXPECT_EQ(jsoncpp::to_json_parallel(data.counters, opts), jsoncpp::to_json(data.counters));
+
+    // 低于阈值时走串行路径
+    std::vector<int> small = {1, 2, 3};
+    EXPECT_EQ(jsoncpp::to_json_parallel(small, opts), "[1,2,3]");
+}
+
+TEST(JsonCppTest, CompressedFixtureTest) {
+    // 测试从 gzip 压缩的 fixture 文件流式解码（含后台解压）
+    jsoncpp::stream_options opts;
+    opts.chunk_size = 1024;
+    for (bool background : {false, true}) {
+        opts.background = background;
+        auto records = jsoncpp::from_json_file<std::vector<record_data>>(JSONCPP_TEST_FIXTURE_DIR "/records.json.gz", opts);
+        ASSERT_EQ(records->size(), 1000);
+        EXPECT_EQ((*records)[999].id, 999);
+        EXPECT_EQ((*records)[1].level, "warn");
+
+        std::vector<record_data> events;
+        jsoncpp::read_ndjson<record_data>(JSONCPP_TEST_FIXTURE_DIR "/events.ndjson.gz", [&](record_data &&r) {
+            events.push_back(std::move(r));
+        }, opts);
+        ASSERT_EQ(events.size(), 1000);
+        EXPECT_EQ(events[2].level, "error");
+        EXPECT_DOUBLE_EQ(events[10].score, 5.0);
+    }
+}
+
+// 每次调用生成不同的临时文件路径，避免并发运行的测试互相覆盖
+static std::string unique_temp_path(const std::string &name) {
+    static std::atomic<unsigned> counter{0};
+    auto suffix = std::to_string(std::random_device{}()) + "_" + std::to_string(counter++);
+    return (std::filesystem::temp_directory_path() / ("jsoncpp_" + suffix + "_" + name)).string();
+}
+
+#ifdef JSONCPP_HAS_ZSTD
+TEST(JsonCppTest, ZstdFixtureTest) {
+    // fixture 由两个拼接的 zstd 帧组成
+    for (bool background : {false, true}) {
+        jsoncpp::stream_options opts;
+        opts.background = background;
+        opts.chunk_size = 1024;
+        std::vector<record_data> events;
+        jsoncpp::read_ndjson<record_data>(JSONCPP_TEST_FIXTURE_DIR "/events.ndjson.zst", [&](record_data &&r) {
+            events.push_back(std::move(r));
+        }, opts);
+        ASSERT_EQ(events.size(), 1000);
+        EXPECT_EQ(events[999].id, 999);
+        EXPECT_EQ(events[502].level, "warn");
+    }
+}
+#endif
+
+TEST(JsonCppTest, NdjsonErrorTest) {
+    // 语法错误带行号；回调抛出的异常原样传播
+    std::string path = unique_temp_path("errors.ndjson");
+    {
+        jsoncpp::compressed_sink sink(path, jsoncpp::compression::none);
+        sink.write("{\"id\":1}\n\n{\"id\":2,]\n");
+    }
+    try {
+        jsoncpp::read_ndjson<record_data>(path, [](record_data &&) {});
+        FAIL() << "expected a parse error";
+    } catch (const boost::system::system_error &e) {
+        EXPECT_NE(std::string(e.what()).find("NDJSON line 3"), std::string::npos);
+    }
+
+    EXPECT_THROW(jsoncpp::read_ndjson<record_data>(path, [](record_data &&) { throw std::logic_error("stop"); }),
+                 std::logic_error);
+    std::filesystem::remove(path);
+}
+
+TEST(JsonCppTest, CompressedRoundTripTest) {
+    // 测试边写边压缩后再读回
+    std::vector<jsoncpp::compression> methods = {jsoncpp::compression::none, jsoncpp::compression::gzip};
+#ifdef JSONCPP_HAS_ZSTD
+    methods.push_back(jsoncpp::compression::zstd);
+#endif
+    for (auto method : methods) {
+        jsoncpp::stream_options opts;
+        opts.method = method;
+        opts.chunk_size = 512;
+
+        main_data data{};
+        data.a = 7;
+        data.b = "compressed";
+        data.c = {1, 2, 3};
+        std::string json_path = unique_temp_path("round_trip.json");
+        jsoncpp::to_json_file(data, json_path, opts);
+        opts.method = jsoncpp::compression::automatic;
+        auto parsed = jsoncpp::from_json_file<main_data>(json_path, opts);
+        EXPECT_EQ(parsed->b, "compressed");
+        EXPECT_EQ(parsed->c, data.c);
+
+        opts.method = method;
+        std::string ndjson_path = unique_temp_path("round_trip.ndjson");
+        {
+            jsoncpp::ndjson_writer<record_data> writer(ndjson_path, opts);
+            for (int i = 0; i < 100; ++i) {
+                writer.write({i, "info", i * 1.5});
+            }
+            writer.finish();
+        }
+        int count = 0;
+        jsoncpp::read_ndjson<record_data>(ndjson_path, [&](record_data &&r) {
+            EXPECT_EQ(r.id, count++);
+        });
+        EXPECT_EQ(count, 100);
+        std::filesystem::remove(json_path);
+        std::filesystem::remove(ndjson_path);
+    }
+}
+
+TEST(JsonCppTest, CanonicalHashTest) {
+    // 测试规范哈希与序列化结果、字段顺序和数字格式无关
+    main_data data{};
+    data.a = 42;
+    data.b = "hash\n\"me\"";
+    data.c = {3, 2, 1};
+    data.d = true;
+    data.e = {{"z", 1}, {"y", 2}};
+
+    EXPECT_EQ(jsoncpp::to_canonical_json(data),
+              "{\"a\":42,\"alias_f\":{\"data\":0},\"b\":\"hash\\n\\\"me\\\"\",\"c\":[3,2,1],\"d\":true,\"e\":{\"y\":2,\"z\":1}}");
+    EXPECT_EQ(jsoncpp::hash(data), jsoncpp::hash_json(jsoncpp::to_json(data)));
+    EXPECT_EQ(jsoncpp::fingerprint128(data), jsoncpp::fingerprint128_json(jsoncpp::to_json(data)));
+
+    EXPECT_EQ(jsoncpp::hash_json("{\"b\": 1, \"a\": [2.0, 1e2]}"), jsoncpp::hash_json("{\"a\":[2,100],\"b\":1}"));
+    EXPECT_NE(jsoncpp::hash_json("{\"a\":1}"), jsoncpp::hash_json("{\"a\":2}"));
+    EXPECT_NE(jsoncpp::hash(data, 1), jsoncpp::hash(data));
+
+    // XXH64 参考值
+    EXPECT_EQ(jsoncpp::hash(std::string("")), jsoncpp::hash_json("\"\""));
+    jsoncpp::detail::xxh64 h;
+    h.append("abc", 3);
+    EXPECT_EQ(h.digest(), 0x44BC2CF5AD770999ULL);
+}
+
+TEST(JsonCppTest, CanonicalHashIntegerPrecisionTest) {
+    // RFC 8785 按 double 规范化数字：超过 2^53 的相邻整数无法区分
+    int64_t big = int64_t{1} << 53;
+    EXPECT_EQ(jsoncpp::to_canonical_json(big + 1), "9007199254740992");
+    EXPECT_EQ(jsoncpp::hash(big), jsoncpp::hash(big + 1));
+    EXPECT_EQ(jsoncpp::fingerprint128(big), jsoncpp::fingerprint128(big + 1));
+    EXPECT_NE(jsoncpp::hash(big - 1), jsoncpp::hash(big));
+
+    // 超过 INT64_MAX 的无符号整数与 to_json 一样回绕为负数
+    uint64_t huge = uint64_t{1} << 63;
+    EXPECT_EQ(jsoncpp::hash(huge), jsoncpp::hash(std::numeric_limits<int64_t>::min()));
+
+    // 以字符串保存的大整数 id 仍然可以区分
+    EXPECT_NE(jsoncpp::hash(std::to_string(big)), jsoncpp::hash(std::to_string(big + 1)));
+}
+
+// 引用保留模式测试用的共享对象图
+class config_data {
+public:
+    std::string name;
+    int version;
+};
+
+class node_data {
+public:
+    int id;
+    std::shared_ptr<config_data> config;
+};
+
+class graph_node {
+public:
+    std::string name;
+    std::vector<std::shared_ptr<graph_node>> next;
+};
+
+TEST(JsonCppTest, SharedReferenceTest) {
+    // 测试共享对象只输出一次，解码后恢复共享关系
+    auto config = std::make_shared<config_data>(config_data{"shared", 3});
+    std::vector<node_data> nodes = {{1, config}, {2, config}, {3, config}};
+
+    std::string plain = jsoncpp::to_json(nodes);
+    EXPECT_EQ(plain.find("$ref"), std::string::npos);
+
+    std::string json_str = jsoncpp::to_json_refs(nodes);
+    EXPECT_EQ(json_str, "[{\"id\":1,\"config\":{\"$id\":1,\"name\":\"shared\",\"version\":3}},"
+                        "{\"id\":2,\"config\":{\"$ref\":1}},{\"id\":3,\"config\":{\"$ref\":1}}]");
+
+    auto parsed = jsoncpp::from_json_refs<std::vector<node_data>>(json_str);
+    ASSERT_EQ(parsed->size(), 3);
+    EXPECT_EQ((*parsed)[0].config->name, "shared");
+    EXPECT_EQ((*parsed)[0].config, (*parsed)[1].config);
+    EXPECT_EQ((*parsed)[1].config, (*parsed)[2].config);
+
+    EXPECT_THROW(jsoncpp::from_json_refs<std::vector<node_data>>("[{\"id\":1,\"config\":{\"$ref\":7}}]"),
+                 boost::system::system_error);
+}
+
+// 通过自定义转换器输出 shared_ptr 的类型，规范哈希会走 transform 回退路径
+class holder_data {
+public:
+    std::shared_ptr<config_data> first;
+    std::shared_ptr<config_data> second;
+};
+
+namespace jsoncpp {
+    template<>
+    struct transform<holder_data> {
+        static void trans(const bj::value &jv, holder_data &t) {
+            bj::object const &jo = jv.as_object();
+            transform<std::shared_ptr<config_data>>::trans(jo.at("first"), t.first);
+            transform<std::shared_ptr<config_data>>::trans(jo.at("second"), t.second);
+        }
+
+        static bj::value to_json(const holder_data &t) {
+            bj::object obj;
+            obj["first"] = transform<std::shared_ptr<config_data>>::to_json(t.first);
+            obj["second"] = transform<std::shared_ptr<config_data>>::to_json(t.second);
+            return obj;
+        }
+    };
+}
+
+TEST(JsonCppTest, SharedReferenceParallelTest) {
+    // 引用保留模式下并行序列化回退为串行，结果与同一作用域内的 to_json 一致
+    auto config = std::make_shared<config_data>(config_data{"shared", 3});
+    std::vector<node_data> nodes;
+    std::vector<std::shared_ptr<config_data>> configs;
+    for (int i = 0; i < 1000; ++i) {
+        nodes.push_back({i, config});
+        configs.push_back(config);
+    }
+
+    jsoncpp::parallel_options opts;
+    opts.threshold = 10;
+    opts.chunk_size = 16;
+    opts.threads = 4;
+
+    std::string serial_nodes, parallel_nodes;
+    {
+        jsoncpp::preserve_references scope;
+        serial_nodes = jsoncpp::to_json(nodes);
+    }
+    {
+        jsoncpp::preserve_references scope;
+        parallel_nodes = jsoncpp::to_json_parallel(nodes, opts);
+    }
+    EXPECT_EQ(parallel_nodes, serial_nodes);
+    EXPECT_EQ(parallel_nodes.find("$id"), parallel_nodes.rfind("$id"));
+
+    // 顶层为 shared_ptr 容器时也同样登记 id
+    std::string serial_configs, parallel_configs;
+    {
+        jsoncpp::preserve_references scope;
+        serial_configs = jsoncpp::to_json(configs);
+    }
+    {
+        jsoncpp::preserve_references scope;
+        parallel_configs = jsoncpp::to_json_parallel(configs, opts);
+    }
+    EXPECT_EQ(parallel_configs, serial_configs);
+    EXPECT_NE(parallel_configs.find("$ref"), std::string::npos);
+
+    // 作用域外仍然并行编码完整值
+    EXPECT_EQ(jsoncpp::to_json_parallel(nodes, opts), jsoncpp::to_json(nodes));
+}
+
+TEST(JsonCppTest, SharedReferenceHashTest) {
+    // 规范哈希忽略引用保留模式，始终对完整值计算
+    auto config = std::make_shared<config_data>(config_data{"shared", 3});
+    holder_data holder{config, config};
+    node_data node{1, config};
+
+    std::string canonical = jsoncpp::to_canonical_json(holder);
+    uint64_t holder_hash = jsoncpp::hash(holder);
+    auto holder_fingerprint = jsoncpp::fingerprint128(holder);
+    uint64_t node_hash = jsoncpp::hash(node);
+
+    jsoncpp::preserve_references scope;
+    std::string scoped = jsoncpp::to_canonical_json(holder);
+    EXPECT_EQ(scoped, canonical);
+    EXPECT_EQ(scoped.find("$ref"), std::string::npos);
+    EXPECT_EQ(jsoncpp::hash(holder), holder_hash);
+    EXPECT_EQ(jsoncpp::fingerprint128(holder), holder_fingerprint);
+    EXPECT_EQ(jsoncpp::hash(node), node_hash);
+
+    // 暂停结束后引用保留模式恢复
+    EXPECT_NE(jsoncpp::to_json(holder).find("$ref"), std::string::npos);
+}
+
+TEST(JsonCppTest, SharedReferenceCycleTest) {
+    // 测试环状引用的编码与还原
+    auto a = std::make_shared<graph_node>();
+    auto b = std::make_shared<graph_node>();
+    a->name = "a";
+    b->name = "b";
+    a->next = {b};
+    b->next = {a};
+
+    std::string json_str = jsoncpp::to_json_refs(a);
+    auto parsed = jsoncpp::from_json_refs<std::shared_ptr<graph_node>>(json_str);
+    auto pa = *parsed;
+    ASSERT_EQ(pa->next.size(), 1);
+    EXPECT_EQ(pa->next[0]->name, "b");
+    EXPECT_EQ(pa->next[0]->next[0], pa);
+
+    // 打破环以释放内存
+    a->next.clear();
+    pa->next[0]->next.clear();
+}
+
+TEST(JsonCppTest, SharedReferenceLifetimeTest) {
+    // 作用域内释放并重新分配对象：新对象即使复用同一地址也不能被当作已输出的 $ref
+    jsoncpp::preserve_references scope;
+    std::vector<std::string> outputs;
+    for (int i = 0; i < 8; ++i) {
+        auto config = std::make_shared<config_data>(config_data{"config_" + std::to_string(i), i});
+        outputs.push_back(jsoncpp::to_json(node_data{i, config}));
+    }
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(outputs[i].find("$ref"), std::string::npos);
+        EXPECT_NE(outputs[i].find("config_" + std::to_string(i)), std::string::npos);
+    }
+}
+
+TEST(JsonCppTest, EmbeddedNulStringTest) {
+    // 测试字符串按实际长度拷贝，不在内嵌 NUL 处截断
+    auto test = jsoncpp::from_json<main_data>("{\"b\":\"log\\u0000tail\"}");
+    EXPECT_EQ(test->b.size(), 8);
+    EXPECT_EQ(test->b, std::string("log\0tail", 8));
+    EXPECT_EQ(jsoncpp::from_json<main_data>(jsoncpp::to_json(*test))->b, test->b);
+
+    EXPECT_THROW(jsoncpp::from_json<main_data>("{\"d\":\"1\\u0000\"}"), boost::system::system_error);
+}
+
+TEST(JsonCppTest, EscapeKernelTest) {
+    // 测试向量化转义扫描与逐字节结果一致，且转义输出与 boost::json 相同
+    std::string text(1000, 'x');
+    EXPECT_EQ(jsoncpp::detail::find_escape(text.data(), text.size()), text.size());
+    for (std::size_t pos : {0, 15, 16, 31, 32, 33, 500, 999}) {
+        for (char c : {'"', '\\', '\n', '\0', '\x1f'}) {
+            std::string s = text;
+            s[pos] = c;
+            EXPECT_EQ(jsoncpp::detail::find_escape(s.data(), s.size()), pos);
+        }
+    }
+    EXPECT_EQ(jsoncpp::detail::find_escape("\x7f\xff/", 3), 3);
+
+    std::string mixed = text + "<a href=\"x\">\t\x01\\</a>" + text;
+    std::string out;
+    jsoncpp::detail::string_sink sink(out);
+    jsoncpp::detail::write_escaped_string(sink, mixed);
+    EXPECT_EQ(out, bj::serialize(bj::string(mixed.data(), mixed.size())));
+}
+
+TEST(JsonCppTest, DirectEncoderTest) {
+    // 测试 to_json（直接写出器）、并行编码器和压缩写出的结果与 boost::json 序列化值树逐字节一致（长字符串含转义）
+    std::string text(300, 'x');
+    snapshot_data data;
+    data.name = text + "\"quoted\"\n" + text;
+    for (int i = 0; i < 500; ++i) {
+        std::string level = (i % 2 ? "line\t" : "path\\") + text + std::string(1, static_cast<char>(i % 32));
+        data.records.push_back({i, level, i * 0.1});
+        data.counters["key \"" + std::to_string(i) + "\""] = -i;
+    }
+
+    std::string expected = bj::serialize(jsoncpp::transform<snapshot_data>::to_json(data));
+    EXPECT_EQ(jsoncpp::to_json(data), expected);
+
+    main_data mixed{};
+    mixed.b = "<a href=\"x\">\x01</a>";
+    mixed.c = {-1, 0, 1};
+    mixed.e["k\\"] = 2;
+    EXPECT_EQ(jsoncpp::to_json(mixed), bj::serialize(jsoncpp::transform<main_data>::to_json(mixed)));
+
+    jsoncpp::parallel_options opts;
+    opts.threshold = 50;
+    opts.chunk_size = 16;
+    opts.threads = 4;
+    EXPECT_EQ(jsoncpp::to_json_parallel(data, opts), expected);
+
+    jsoncpp::stream_options stream_opts;
+    stream_opts.method = jsoncpp::compression::none;
+    stream_opts.chunk_size = 64;
+    std::string json_path = unique_temp_path("direct.json");
+    jsoncpp::to_json_file(data, json_path, stream_opts);
+    {
+        std::ifstream file(json_path, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(content, expected);
+    }
+
+    stream_opts.method = jsoncpp::compression::gzip;
+    std::string ndjson_path = unique_temp_path("direct.ndjson.gz");
+    {
+        jsoncpp::ndjson_writer<record_data> writer(ndjson_path, stream_opts);
+        for (const auto &record : data.records) {
+            writer.write(record);
+        }
+    }
+    std::size_t count = 0;
+    jsoncpp::read_ndjson<record_data>(ndjson_path, [&](record_data &&r) {
+        ASSERT_LT(count, data.records.size());
+        EXPECT_EQ(r.level, data.records[count++].level);
+    });
+    EXPECT_EQ(count, data.records.size());
+    std::filesystem::remove(json_path);
+    std::filesystem::remove(ndjson_path);
+}
+
 int main() {
     ::testing::InitGoogleTest();
     return RUN_ALL_TESTS();
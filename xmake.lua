@@ -1,4 +1,5 @@
-add_requires("boost[json,pfr]", "gtest")
+add_requires("boost[json,pfr]", "gtest", "zlib")
+add_requires("zstd", {optional = true})
 
 add_rules("plugin.compile_commands.autoupdate", {outputdir = "build"})
 set_languages("c++23")
@@ -9,5 +10,14 @@ target("test")
     set_kind("binary")
     set_group("tests")
     add_files("test/test.cpp")
-    add_packages("gtest", "boost")
+    add_packages("gtest", "boost", "zlib", "zstd")
+    add_defines("JSONCPP_TEST_FIXTURE_DIR=\"$(projectdir)/test/fixtures\"")
+    on_load(function (target)
+        if target:pkg("zstd") then
+            target:add("defines", "JSONCPP_HAS_ZSTD")
+        end
+    end)
     add_includedirs("include")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end